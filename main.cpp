@@ -6,6 +6,13 @@ using namespace std::chrono;
 const int MAX_ITER = 10000;              // Número máximo de iteraciones
 const int TABU_SIZE = 15;                // Tenure: iteraciones que un movimiento permanece tabú
 const int CANDIDATE_LIST_SIZE = 200;     // Número de candidatos aleatorios evaluados por iteración
+const int BEST_FREQ_TRXS = 8;            // TRXs en conflicto evaluados por iteración en modo best-frequency
+const double PENALIZACION_INF = 1e18;    // Costo de una frecuencia no permitida en el barrido del espectro
+const int VISITADOS_BITS = 16;           // Tabla de estados visitados: 2^VISITADOS_BITS entradas
+const int ESPECTROS_BITS = 16;           // Caché de barridos por (estado, TRX): 2^ESPECTROS_BITS entradas
+const int CICLO_MAX_VISITAS = 3;         // Revisitas de un mismo estado que disparan la diversificación
+const int DIVERSIFICACION_MOVS = 10;     // Movimientos aleatorios aplicados al diversificar
+const double EDIT_REOPT_SECONDS = 1.0;   // Modo servidor: segundos de re-optimización tras un EDIT (por defecto)
 
 // Función hash simple para tuple<int, int, int> para usar en unordered_map
 struct TupleHash {
@@ -27,15 +34,25 @@ struct Interference {
     double v_adj = 0.0;        // Penalización por interferencia adjacent-channel (frecuencias adyacentes)
 };
 
+struct Vecino {
+    int cell;                  // Celda con la que existe una relación DA
+    double v_co;               // Penalización co-channel de la relación
+    double v_adj;              // Penalización adjacent-channel de la relación
+};
+
 class Problem {
 public:
-    int fmin, fmax;                                      // Rango del espectro disponible
-    int co_site_sep;                                     // Separación mínima entre frecuencias en el mismo sitio
+    int fmin = 0, fmax = -1;                             // Rango del espectro disponible (vacío si no hay SPECTRUM)
+    int co_site_sep = 0;                                 // Separación mínima entre frecuencias en el mismo sitio
     set<int> globally_blocked;                           // Frecuencias bloqueadas globalmente
     unordered_map<int, Cell> cells;                      // Diccionario de celdas por ID
     map<pair<int, int>, Interference> relations;         // Relaciones de interferencia entre pares de celdas (map por pair)
     unordered_map<int, vector<int>> domains;             // Dominio de frecuencias permitidas por celda
     vector<int> freqs_disponibles;                       // Lista de frecuencias disponibles en el espectro
+    unordered_map<int, vector<Vecino>> vecinos;          // Relaciones DA indexadas por celda (ambos sentidos)
+    unordered_map<int, vector<int>> mismo_sitio;         // Otras celdas del mismo sitio (restricción co-site)
+    unordered_map<int, vector<double>> penal_dominio;    // Por celda: 0 si f-fmin está en el dominio, PENALIZACION_INF si no
+    unordered_map<int, vector<uint64_t>> zobrist;        // Por celda: clave aleatoria de (trx, f) en [trx * ancho + f - fmin]
 
 
     // Carga una instancia desde un archivo .scen (formato COST259)
@@ -71,7 +88,14 @@ public:
                 curr_rel = {-1, -1};
             }
         }
+        if (cells.empty() || fmax < fmin) {
+            cerr << "Error: " << filename << " no es un escenario valido (sin CELLS o SPECTRUM)" << endl;
+            return false;
+        }
+
         calc_domains();
+        calc_vecinos();
+        calc_zobrist();
         return true;
     }
 
@@ -221,6 +245,52 @@ private:
             }
         }
     }
+
+    /**
+     * Precalcula los índices por celda usados por el barrido del espectro:
+     * vecinos DA, celdas del mismo sitio y máscara del dominio
+     */
+    void calc_vecinos() {
+        for (auto& [par, inf] : relations) {
+            vecinos[par.first].push_back({par.second, inf.v_co, inf.v_adj});
+            if (par.first != par.second) {
+                vecinos[par.second].push_back({par.first, inf.v_co, inf.v_adj});
+            }
+        }
+
+        for (auto& [id1, c1] : cells) {
+            for (auto& [id2, c2] : cells) {
+                if (id1 != id2 && c1.site == c2.site) mismo_sitio[id1].push_back(id2);
+            }
+        }
+
+        int ancho = fmax - fmin + 1;
+        for (auto& [id, dom] : domains) {
+            auto& pen = penal_dominio[id];
+            pen.assign(ancho, PENALIZACION_INF);
+            for (int f : dom) pen[f - fmin] = 0.0;
+        }
+    }
+
+    /**
+     * Genera las claves Zobrist: un entero aleatorio de 64 bits por cada
+     * combinación (celda, trx, frecuencia). Semilla fija para que el hash
+     * de una asignación sea reproducible entre ejecuciones
+     */
+    void calc_zobrist() {
+        mt19937_64 gen(0x9E3779B97F4A7C15ULL);
+        int ancho = fmax - fmin + 1;
+
+        // Recorrer celdas en orden de ID para no depender del orden del unordered_map
+        map<int, Cell*> ordenadas;
+        for (auto& [id, cell] : cells) ordenadas[id] = &cell;
+
+        for (auto& [id, cell] : ordenadas) {
+            auto& claves = zobrist[id];
+            claves.resize((size_t)cell->demand * ancho);
+            for (auto& k : claves) k = gen();
+        }
+    }
 };
 
 /**
@@ -232,6 +302,7 @@ public:
     unordered_map<int, vector<int>> asignacion;    // cell_id -> [freq1, freq2, ..., freq_n]
     Problem* prob;                                  // Puntero a la instancia del problema
     double costo;                                   // Valor de la función objetivo (interferencias totales)
+    uint64_t hash = 0;                              // Hash Zobrist de 'asignacion'
 
     Solution(Problem* p) : prob(p), costo(1e9) {}
     Solution() : prob(nullptr), costo(1e9) {}
@@ -291,8 +362,9 @@ public:
      * - Asigna exactamente 'demand' frecuencias a cada celda
      * - Solo usa frecuencias del dominio permitido
      * - Respeta la separación co-site mínima
+     * @return false si alguna celda no tiene dominio suficiente para su demanda
      */
-    void generar_inicial() {
+    bool generar_inicial() {
         random_device rd;
         mt19937 gen(rd());
         
@@ -301,7 +373,7 @@ public:
             auto& dom = prob->domains[id];
             if (dom.size() < (size_t)cell.demand) {
                 cerr << "ERROR: Dominio insuficiente para celda " << id << endl;
-                exit(1);
+                return false;
             }
         }
         
@@ -319,7 +391,7 @@ public:
                     factibles = dom;
                     if (factibles.empty()) {
                         cerr << "ERROR: Dominio vacio para celda " << id << endl;
-                        exit(1);
+                        return false;
                     }
                 }
                 
@@ -329,6 +401,46 @@ public:
         }
         
         calcular_costo();
+        calcular_hash();
+        return true;
+    }
+
+    /**
+     * Calcula el hash Zobrist desde cero: XOR de las claves de cada (celda, trx, frecuencia)
+     * Después de esto basta aplicar_movimiento para mantenerlo en O(1)
+     */
+    void calcular_hash() {
+        int ancho = prob->fmax - prob->fmin + 1;
+        hash = 0;
+        for (auto& [id, freqs] : asignacion) {
+            auto& claves = prob->zobrist[id];
+            for (size_t i = 0; i < freqs.size(); ++i) {
+                hash ^= claves[i * ancho + (freqs[i] - prob->fmin)];
+            }
+        }
+    }
+
+    // XOR de las claves Zobrist de la frecuencia actual y la nueva: hash ^ clave = hash del vecino
+    uint64_t clave_movimiento(int cell_id, size_t trx_idx, int new_freq) const {
+        int ancho = prob->fmax - prob->fmin + 1;
+        auto& claves = prob->zobrist.at(cell_id);
+        int f = asignacion.at(cell_id)[trx_idx];
+        return claves[trx_idx * ancho + (f - prob->fmin)] ^ claves[trx_idx * ancho + (new_freq - prob->fmin)];
+    }
+
+    /**
+     * Aplica un movimiento 1-opt con su costo ya calculado (delta)
+     * Actualiza el hash en O(1): quita la clave de la frecuencia anterior y agrega la nueva
+     */
+    void aplicar_movimiento(int cell_id, size_t trx_idx, int new_freq, double nuevo_costo) {
+        hash ^= clave_movimiento(cell_id, trx_idx, new_freq);
+        asignacion[cell_id][trx_idx] = new_freq;
+
+        costo = nuevo_costo;
+        // Evitar errores de precisión de punto flotante
+        if (fabs(costo) < 1e-9) {
+            costo = 0.0;
+        }
     }
 
     /**
@@ -404,6 +516,102 @@ public:
 };
 
 
+// Estrategia de generación de vecinos usada por TabuSearch
+enum class Vecindario {
+    CANDIDATE_LIST,            // Movimientos aleatorios (celda, trx, frecuencia)
+    BEST_FREQUENCY             // Mejor frecuencia del dominio para TRXs en conflicto
+};
+
+struct EstadoVisitado {
+    uint64_t hash = 0;         // Hash Zobrist del estado que ocupa la entrada
+    int visitas = 0;           // Veces que la búsqueda ha pasado por este estado
+};
+
+/**
+ * Tabla compacta de estados visitados (direct-mapped, 2^bits entradas)
+ * Cada hash ocupa la entrada hash & mascara; si otro estado la ocupaba, se reemplaza
+ */
+class TablaVisitados {
+public:
+    long consultas = 0;        // Estados registrados
+    long revisitas = 0;        // Estados que ya estaban en la tabla
+    long reemplazos = 0;       // Entradas sobrescritas por otro estado
+
+    TablaVisitados(int bits = VISITADOS_BITS) : entradas(1u << bits), mascara((1u << bits) - 1) {}
+
+    // Registra el estado y devuelve su entrada; 'revisitado' indica si ya estaba en la tabla
+    EstadoVisitado& registrar(uint64_t hash, bool& revisitado) {
+        consultas++;
+        EstadoVisitado& e = entradas[hash & mascara];
+        revisitado = (e.visitas > 0 && e.hash == hash);
+        if (revisitado) {
+            revisitas++;
+        } else {
+            if (e.visitas > 0) reemplazos++;
+            e = EstadoVisitado();
+            e.hash = hash;
+        }
+        e.visitas++;
+        return e;
+    }
+
+    void limpiar() {
+        fill(entradas.begin(), entradas.end(), EstadoVisitado());
+        consultas = revisitas = reemplazos = 0;
+    }
+
+private:
+    vector<EstadoVisitado> entradas;
+    uint64_t mascara;
+};
+
+struct EspectroTRX {
+    uint64_t clave = 0;        // Clave (estado, TRX); 0 marca entrada vacía
+    double costo_old = 0.0;    // Costo del TRX con su frecuencia actual
+    int f_mejor = -1;          // Mejor frecuencia factible sin mirar la lista tabú (-1: ninguna)
+    double c_mejor = 0.0;      // Costo del TRX con f_mejor
+    int f_libre = -1;          // Mejor frecuencia no tabú al momento del barrido (-1: ninguna)
+    double c_libre = 0.0;      // Costo del TRX con f_libre
+};
+
+/**
+ * Caché compacta (direct-mapped) del resultado de barrer_espectro por (estado, TRX)
+ * Las revisitas ocurren sobre todo en modo best-frequency; al volver a un estado
+ * se reutiliza el resultado del barrido y solo se vuelve a consultar la lista tabú
+ */
+class CacheEspectros {
+public:
+    long consultas = 0;        // Barridos solicitados
+    long aciertos = 0;         // Barridos servidos desde la caché
+
+    CacheEspectros(int bits = ESPECTROS_BITS) : entradas(1u << bits), mascara((1u << bits) - 1) {}
+
+    // Combina el hash del estado con una clave propia del TRX
+    static uint64_t clave(uint64_t hash_estado, uint64_t clave_trx) {
+        return (hash_estado * 0x9E3779B97F4A7C15ULL) ^ clave_trx;
+    }
+
+    // Devuelve la entrada guardada para la clave, o nullptr si no está
+    EspectroTRX* buscar(uint64_t k) {
+        consultas++;
+        EspectroTRX& e = entradas[k & mascara];
+        return e.clave == k ? &e : nullptr;
+    }
+
+    void guardar(const EspectroTRX& e) {
+        entradas[e.clave & mascara] = e;
+    }
+
+    void limpiar() {
+        fill(entradas.begin(), entradas.end(), EspectroTRX());
+        consultas = aciertos = 0;
+    }
+
+private:
+    vector<EspectroTRX> entradas;
+    uint64_t mascara;
+};
+
 /**
  * Implementa el algoritmo de Búsqueda Tabú con estrategia Candidate List
  * 
@@ -412,12 +620,21 @@ public:
  * - Lista Tabú: Prohíbe movimientos inversos por TABU_SIZE iteraciones
  * - Candidate List: Genera y evalúa CANDIDATE_LIST_SIZE candidatos aleatorios
  * - Estrategia: Mejor Mejora sobre el subset de candidatos
+ * - Modo alternativo best-frequency: para TRXs en conflicto evalúa todo el
+ *   espectro de una vez y elige la mejor frecuencia del dominio
  */
 class TabuSearch {
 public:
     Problem problema;                                                    // Instancia del problema
+    Solution actual;                                                     // Solución actual de la trayectoria
     Solution mejor;                                                      // Mejor solución encontrada
     unordered_map<tuple<int, int, int>, int, TupleHash> lista_tabu;     // (cell, trx, old_freq) -> iteración_prohibida
+    set<pair<int, size_t>> trx_fijos;                                    // (cell, trx) fijados por EDIT: no se mueven
+    int iter_global = 0;                                                 // Iteraciones acumuladas entre llamadas a optimizar
+    Vecindario vecindario = Vecindario::CANDIDATE_LIST;                  // Estrategia de generación de vecinos
+    TablaVisitados visitados;                                            // Estados visitados (hash Zobrist)
+    long diversificaciones = 0;                                          // Ciclos que dispararon diversificación
+    CacheEspectros cache_espectros;                                      // Barridos del espectro por (estado, TRX)
     double tiempo_ejecucion;                                             // Tiempo de ejecución en segundos
 
     /**
@@ -449,42 +666,16 @@ public:
         log << "CO_SITE_SEPARATION: " << problema.co_site_sep << endl;
         log << "MAX_ITER: " << MAX_ITER << endl;
         log << "TABU_SIZE: " << TABU_SIZE << endl;
+        log << "VECINDARIO: " << (vecindario == Vecindario::BEST_FREQUENCY ? "best-frequency" : "candidate-list") << endl;
         log << endl;
         
-        Solution actual(&problema);
-        actual.generar_inicial();
-        mejor = actual;
+        if (!inicializar()) exit(1);
 
         cout << "Costo inicial: " << mejor.costo << endl;
         log << "Costo inicial: " << mejor.costo << endl << endl;
 
-        for (int it = 0; it < MAX_ITER; ++it) {
-            Solution vecino = buscar_vecino_con_candidate_list(actual, it);
-            
-            if (vecino.prob == nullptr) {
-                log << "No hay mas vecinos factibles en iter " << (it + 1) << endl;
-                cout << "No hay mas vecinos factibles en iter " << (it + 1) << endl;
-                break;
-            }
-
-            actual = vecino;
-
-            if (actual.costo < mejor.costo) {
-                mejor = actual;
-            }
-            
-            string line = "Iter " + to_string(it + 1) + ": actual = " + 
-                         to_string(actual.costo) + ", mejor = " + to_string(mejor.costo);
-            cout << line << endl;
-            log << line << endl;
-            
-            // Terminar si se encuentra solución óptima (costo 0 o muy cercano a 0)
-            if (fabs(mejor.costo) < 1e-9) {
-                log << "Solucion optima encontrada (costo = 0) en iter " << (it + 1) << endl;
-                cout << "Solucion optima encontrada (costo = 0)" << endl;
-                break;
-            }
-        }
+        optimizar(MAX_ITER, 0.0, &log, true);
+        log << endl << estadisticas_ciclos() << endl;
 
         // Detener cronómetro
         auto fin = high_resolution_clock::now();
@@ -511,6 +702,145 @@ public:
         // Guardar solucion final
         guardar_solucion(archivo);
     }
+
+    /**
+     * Genera la solución inicial aleatoria y reinicia la memoria de la búsqueda
+     * Requiere que 'problema' ya esté cargado
+     * @return false (sin modificar el estado) si no se pudo generar la solución inicial
+     */
+    bool inicializar() {
+        Solution inicial(&problema);
+        if (!inicial.generar_inicial()) return false;
+        actual = inicial;
+        mejor = actual;
+        lista_tabu.clear();
+        trx_fijos.clear();
+        iter_global = 0;
+        visitados.limpiar();
+        diversificaciones = 0;
+        cache_espectros.limpiar();
+        return true;
+    }
+
+    // Resumen de revisitas de estados (hash Zobrist) para ajustar la búsqueda
+    string estadisticas_ciclos() const {
+        double tasa = visitados.consultas ? 100.0 * visitados.revisitas / visitados.consultas : 0.0;
+        ostringstream os;
+        os << "Estados: consultas=" << visitados.consultas
+           << " revisitas=" << visitados.revisitas
+           << " tasa_revisita=" << fixed << setprecision(2) << tasa << "%"
+           << " reemplazos=" << visitados.reemplazos
+           << " diversificaciones=" << diversificaciones
+           << " espectros_consultados=" << cache_espectros.consultas
+           << " espectros_en_cache=" << cache_espectros.aciertos
+           << " tasa_acierto=" << (cache_espectros.consultas ? 100.0 * cache_espectros.aciertos / cache_espectros.consultas : 0.0) << "%";
+        return os.str();
+    }
+
+    /**
+     * Continúa la búsqueda tabú desde 'actual' conservando la lista tabú
+     * Se detiene al cumplir max_iter, el límite de tiempo (si > 0), al
+     * encontrar costo 0 o al quedarse sin vecinos factibles
+     * @param log  Archivo de log (puede ser nullptr)
+     * @param eco  Si es true, también escribe el progreso en cout
+     * @return Número de iteraciones realizadas
+     */
+    int optimizar(int max_iter, double limite_segundos, ostream* log, bool eco) {
+        auto inicio = high_resolution_clock::now();
+        int realizadas = 0;
+
+        for (; realizadas < max_iter; ++realizadas) {
+            if (limite_segundos > 0.0) {
+                duration<double> transcurrido = high_resolution_clock::now() - inicio;
+                if (transcurrido.count() >= limite_segundos) break;
+            }
+
+            int it = iter_global++;
+
+            // Detección de ciclos: ¿la trayectoria ya pasó por este estado?
+            bool revisitado;
+            EstadoVisitado& estado = visitados.registrar(actual.hash, revisitado);
+
+            Solution vecino;
+            if (revisitado && estado.visitas > CICLO_MAX_VISITAS) {
+                diversificaciones++;
+                estado.visitas = 0;
+                vecino = diversificar(actual, it);
+                if (log) *log << "Ciclo detectado en iter " << (it + 1) << ": diversificando" << endl;
+            } else {
+                vecino = (vecindario == Vecindario::BEST_FREQUENCY)
+                    ? buscar_vecino_best_frequency(actual, it)
+                    : buscar_vecino_con_candidate_list(actual, it);
+            }
+            
+            if (vecino.prob == nullptr) {
+                string line = "No hay mas vecinos factibles en iter " + to_string(it + 1);
+                if (log) *log << line << endl;
+                if (eco) cout << line << endl;
+                break;
+            }
+
+            actual = vecino;
+
+            if (actual.costo < mejor.costo) {
+                mejor = actual;
+            }
+            
+            string line = "Iter " + to_string(it + 1) + ": actual = " + 
+                         to_string(actual.costo) + ", mejor = " + to_string(mejor.costo);
+            if (eco) cout << line << endl;
+            if (log) *log << line << endl;
+            
+            // Terminar si se encuentra solución óptima (costo 0 o muy cercano a 0)
+            if (fabs(mejor.costo) < 1e-9) {
+                if (log) *log << "Solucion optima encontrada (costo = 0) en iter " << (it + 1) << endl;
+                if (eco) cout << "Solucion optima encontrada (costo = 0)" << endl;
+                ++realizadas;
+                break;
+            }
+        }
+        return realizadas;
+    }
+
+    /**
+     * Edición externa: fija la frecuencia de un TRX en la mejor solución
+     * El TRX queda fijo (la búsqueda no lo vuelve a mover) hasta liberar_trx
+     * La trayectoria se reinicia desde la solución editada
+     * @param trx_idx Índice 0-based del TRX dentro de la celda
+     * @return false (con el motivo en 'error') si la edición no es válida
+     */
+    bool fijar_trx(int cell_id, size_t trx_idx, int freq, string& error) {
+        if (!mejor.asignacion.count(cell_id)) {
+            error = "celda inexistente";
+            return false;
+        }
+        if (trx_idx >= mejor.asignacion[cell_id].size()) {
+            error = "trx fuera de rango";
+            return false;
+        }
+        auto& dom = problema.domains[cell_id];
+        if (find(dom.begin(), dom.end(), freq) == dom.end()) {
+            error = "frecuencia fuera del dominio";
+            return false;
+        }
+        if (!es_factible_trx(cell_id, trx_idx, freq, mejor.asignacion)) {
+            error = "viola separacion co-site";
+            return false;
+        }
+
+        actual = mejor;
+        actual.asignacion[cell_id][trx_idx] = freq;
+        actual.calcular_costo();
+        actual.calcular_hash();
+        mejor = actual;
+        trx_fijos.insert({cell_id, trx_idx});
+        return true;
+    }
+
+    // Libera un TRX fijado previamente con fijar_trx
+    bool liberar_trx(int cell_id, size_t trx_idx) {
+        return trx_fijos.erase({cell_id, trx_idx}) > 0;
+    }
     
     /**
      * Guarda la solución final en un archivo de texto
@@ -615,6 +945,7 @@ private:
             int old_f = s.asignacion.at(cid)[trx_idx];
             
             // Validar movimiento
+            if (trx_fijos.count({cid, trx_idx})) continue;
             if (new_f == old_f) continue;
             if (!es_factible_trx(cid, trx_idx, new_f, s.asignacion)) continue;
             
@@ -628,6 +959,232 @@ private:
         return candidatos;
     }
     
+    // Buffers del barrido del espectro (reutilizados entre llamadas)
+    vector<double> esp_co, esp_adj, esp_costo;
+
+    /**
+     * Diversificación ante un ciclo: aplica DIVERSIFICACION_MOVS movimientos
+     * aleatorios factibles (TRX no fijado, frecuencia del dominio que respeta co-site)
+     * y marca como tabú la vuelta atrás de cada uno
+     */
+    Solution diversificar(const Solution& s, int iter) {
+        random_device rd;
+        mt19937 gen(rd());
+
+        vector<pair<int, size_t>> trxs;
+        for (auto& [cid, freqs] : s.asignacion) {
+            for (size_t i = 0; i < freqs.size(); ++i) {
+                if (!trx_fijos.count({cid, i})) trxs.push_back({cid, i});
+            }
+        }
+
+        Solution nueva = s;
+        if (trxs.empty()) return nueva;
+        uniform_int_distribution<> trx_dist(0, trxs.size() - 1);
+
+        for (int d = 0; d < DIVERSIFICACION_MOVS; ++d) {
+            auto [cid, trx_idx] = trxs[trx_dist(gen)];
+            double costo_old = barrer_espectro(nueva, cid, trx_idx);
+            int old_f = nueva.asignacion[cid][trx_idx];
+
+            vector<int> factibles;
+            for (size_t k = 0; k < esp_costo.size(); ++k) {
+                int f = problema.fmin + k;
+                if (esp_costo[k] < PENALIZACION_INF && f != old_f) factibles.push_back(k);
+            }
+            if (factibles.empty()) continue;
+
+            uniform_int_distribution<> k_dist(0, factibles.size() - 1);
+            int k = factibles[k_dist(gen)];
+            nueva.aplicar_movimiento(cid, trx_idx, problema.fmin + k, nueva.costo + (esp_costo[k] - costo_old));
+            lista_tabu[make_tuple(cid, (int)trx_idx, old_f)] = iter + TABU_SIZE;
+        }
+        return nueva;
+    }
+
+    /**
+     * Calcula en un solo barrido el costo de interferencia de TODAS las
+     * frecuencias del espectro para el TRX (cell_id, trx_idx)
+     * 
+     * 1. Acumula v_co / v_adj de cada TRX vecino en su frecuencia asignada
+     * 2. Parte de la máscara del dominio y bloquea las frecuencias que violan co-site
+     * 3. Combina en un bucle contiguo vectorizado (omp simd, requiere -fopenmp-simd):
+     *    costo[f] = co[f] + adj[f-1] + adj[f+1] + penalizacion[f]
+     * 
+     * Deja en esp_costo[f - fmin] el costo del TRX si usara f
+     * (>= PENALIZACION_INF si f no es factible)
+     * @return Costo actual del TRX con su frecuencia asignada
+     */
+    double barrer_espectro(const Solution& s, int cell_id, size_t trx_idx) {
+        const int fmin = problema.fmin;
+        const int ancho = problema.fmax - fmin + 1;
+        const int sep = problema.co_site_sep;
+
+        // Índices desplazados en 1 para que f-1 y f+1 existan en los bordes
+        esp_co.assign(ancho + 2, 0.0);
+        esp_adj.assign(ancho + 2, 0.0);
+        for (auto& v : problema.vecinos[cell_id]) {
+            auto it = s.asignacion.find(v.cell);
+            if (it == s.asignacion.end()) continue;
+            for (int f : it->second) {
+                esp_co[f - fmin + 1] += v.v_co;
+                esp_adj[f - fmin + 1] += v.v_adj;
+            }
+        }
+
+        esp_costo = problema.penal_dominio[cell_id];
+        auto bloquear = [&](int f) {
+            int lo = max(0, f - fmin - sep + 1);
+            int hi = min(ancho - 1, f - fmin + sep - 1);
+            for (int k = lo; k <= hi; ++k) esp_costo[k] = PENALIZACION_INF;
+        };
+        const auto& propias = s.asignacion.at(cell_id);
+        for (size_t i = 0; i < propias.size(); ++i) {
+            if (i != trx_idx) bloquear(propias[i]);
+        }
+        for (int oid : problema.mismo_sitio[cell_id]) {
+            for (int f : s.asignacion.at(oid)) bloquear(f);
+        }
+
+        const double* co = esp_co.data();
+        const double* adj = esp_adj.data();
+        double* costo = esp_costo.data();
+        #pragma omp simd
+        for (int k = 0; k < ancho; ++k) {
+            costo[k] += co[k + 1] + adj[k] + adj[k + 2];
+        }
+
+        int k_old = propias[trx_idx] - fmin + 1;
+        return esp_co[k_old] + esp_adj[k_old - 1] + esp_adj[k_old + 1];
+    }
+
+    bool es_tabu(int cell_id, size_t trx_idx, int freq, int iter) const {
+        auto tabu = lista_tabu.find(make_tuple(cell_id, (int)trx_idx, freq));
+        return tabu != lista_tabu.end() && tabu->second > iter;
+    }
+
+    /**
+     * Mejor frecuencia no tabú para un TRX, reutilizando el barrido si el
+     * estado (hash Zobrist) ya se había visitado
+     * 
+     * En caché se guardan la mejor frecuencia ignorando la lista tabú y la mejor
+     * no tabú de ese momento; al reutilizar se vuelve a consultar la lista tabú
+     * para ambas y, si las dos son tabú ahora, se barre de nuevo
+     * (aproximación: no ve frecuencias cuyo tabú expiró con costo entre ambas)
+     * @param f      Frecuencia elegida (-1 si no hay movimiento no tabú)
+     * @param c      Costo del TRX con f
+     * @return Costo actual del TRX (0 si no está en conflicto)
+     */
+    double mejor_frecuencia_trx(const Solution& s, int cid, size_t trx_idx, int iter, int& f, double& c) {
+        int ancho = problema.fmax - problema.fmin + 1;
+        uint64_t clave_trx = problema.zobrist[cid][trx_idx * ancho];     // clave propia de (cid, trx, fmin)
+        uint64_t k = CacheEspectros::clave(s.hash, clave_trx);
+
+        if (EspectroTRX* e = cache_espectros.buscar(k)) {
+            f = -1;
+            if (e->costo_old < 1e-9 || e->f_mejor == -1) {
+                cache_espectros.aciertos++;
+                return e->costo_old;
+            }
+            if (!es_tabu(cid, trx_idx, e->f_mejor, iter)) {
+                f = e->f_mejor;
+                c = e->c_mejor;
+            } else if (e->f_libre != -1 && !es_tabu(cid, trx_idx, e->f_libre, iter)) {
+                f = e->f_libre;
+                c = e->c_libre;
+            }
+            if (f != -1) {
+                cache_espectros.aciertos++;
+                return e->costo_old;
+            }
+        }
+
+        EspectroTRX e;
+        e.clave = k;
+        e.costo_old = barrer_espectro(s, cid, trx_idx);
+        if (e.costo_old >= 1e-9) {
+            int old_f = s.asignacion.at(cid)[trx_idx];
+            for (int kf = 0; kf < ancho; ++kf) {
+                if (esp_costo[kf] >= PENALIZACION_INF) continue;
+                int new_f = problema.fmin + kf;
+                if (new_f == old_f) continue;
+
+                if (e.f_mejor == -1 || esp_costo[kf] < e.c_mejor) {
+                    e.f_mejor = new_f;
+                    e.c_mejor = esp_costo[kf];
+                }
+                if ((e.f_libre == -1 || esp_costo[kf] < e.c_libre) && !es_tabu(cid, trx_idx, new_f, iter)) {
+                    e.f_libre = new_f;
+                    e.c_libre = esp_costo[kf];
+                }
+            }
+        }
+        cache_espectros.guardar(e);
+
+        f = e.f_libre;
+        c = e.c_libre;
+        return e.costo_old;
+    }
+
+    /**
+     * Vecindario best-frequency
+     * 
+     * Proceso:
+     * 1. Recorre los TRXs (no fijados) en orden aleatorio
+     * 2. Para cada uno barre el espectro completo (o reutiliza el barrido en caché);
+     *    si no tiene interferencia se salta
+     * 3. Toma la mejor frecuencia no tabú de hasta BEST_FREQ_TRXS TRXs en conflicto
+     * 4. Aplica el mejor movimiento encontrado
+     * 
+     * Si todos los movimientos resultan tabú, recurre a la Candidate List
+     */
+    Solution buscar_vecino_best_frequency(const Solution& s, int iter) {
+        random_device rd;
+        mt19937 gen(rd());
+
+        vector<pair<int, size_t>> trxs;
+        for (auto& [cid, freqs] : s.asignacion) {
+            for (size_t i = 0; i < freqs.size(); ++i) {
+                if (!trx_fijos.count({cid, i})) trxs.push_back({cid, i});
+            }
+        }
+        shuffle(trxs.begin(), trxs.end(), gen);
+
+        int evaluados = 0;
+        int mejor_cid = -1;
+        size_t mejor_trx = 0;
+        int mejor_f = 0;
+        double mejor_costo = 1e9;
+
+        for (auto& [cid, trx_idx] : trxs) {
+            if (evaluados >= BEST_FREQ_TRXS) break;
+
+            int f;
+            double c;
+            double costo_old = mejor_frecuencia_trx(s, cid, trx_idx, iter, f, c);
+            if (costo_old < 1e-9) continue;
+            evaluados++;
+            if (f == -1) continue;
+
+            double nuevo_costo = s.costo + (c - costo_old);
+            if (nuevo_costo < mejor_costo) {
+                mejor_cid = cid;
+                mejor_trx = trx_idx;
+                mejor_f = f;
+                mejor_costo = nuevo_costo;
+            }
+        }
+
+        if (mejor_cid == -1) return buscar_vecino_con_candidate_list(s, iter);
+
+        int old_f = s.asignacion.at(mejor_cid)[mejor_trx];
+        Solution mejor_vecino = s;
+        mejor_vecino.aplicar_movimiento(mejor_cid, mejor_trx, mejor_f, mejor_costo);
+
+        lista_tabu[make_tuple(mejor_cid, (int)mejor_trx, old_f)] = iter + TABU_SIZE;
+        return mejor_vecino;
+    }
+    
     Solution buscar_vecino_con_candidate_list(const Solution& s, int iter) {
         random_device rd;
         mt19937 gen(rd());
@@ -671,15 +1228,9 @@ private:
         if (mejor_idx != -1) {
             auto& [cid, trx_idx, old_f, new_f] = candidatos[mejor_idx];
             
-            // Crear vecino con el movimiento
+            // Crear vecino con el movimiento (usar costo ya calculado)
             Solution mejor_vecino = s;
-            mejor_vecino.asignacion[cid][trx_idx] = new_f;
-            mejor_vecino.costo = mejor_costo;  // Usar costo ya calculado
-            
-            // Evitar errores de precisión de punto flotante
-            if (fabs(mejor_vecino.costo) < 1e-9) {
-                mejor_vecino.costo = 0.0;
-            }
+            mejor_vecino.aplicar_movimiento(cid, trx_idx, new_f, mejor_costo);
             
             lista_tabu[mejor_mov_inverso] = iter + TABU_SIZE;
             return mejor_vecino;
@@ -691,11 +1242,253 @@ private:
     }
 };
 
+/**
+ * Modo servidor (daemon residente): protocolo de líneas sobre stdin/stdout
+ * 
+ * Mantiene en memoria cada instancia cargada (Problem ya parseado, dominios,
+ * mejor solución, trayectoria actual y lista tabú), de modo que las consultas
+ * repetidas no vuelven a pagar el parseo ni reinician desde una solución aleatoria.
+ * 
+ * Comandos (una línea cada uno, TRX numerados desde 1 como en *_solution.txt):
+ *   LOAD <archivo>                                  Carga (o reutiliza) una instancia
+ *   SOLVE <archivo> <segundos> [max_iter]           Continúa la búsqueda desde el estado guardado
+ *   EDIT <archivo> <celda> <trx> <freq> [segundos]  Fija un TRX y re-optimiza el resto
+ *   FREE <archivo> <celda> <trx>                    Libera un TRX fijado con EDIT
+ *   GET <archivo>                                   Devuelve la mejor asignación
+ *   RESET <archivo>                                 Nueva solución inicial aleatoria
+ *   MODE <archivo> candidate-list|best-frequency    Cambia el vecindario usado por SOLVE/EDIT
+ *   STATS <archivo>                                 Estadísticas de revisitas / ciclos
+ *   UNLOAD <archivo>                                Elimina la instancia de memoria
+ *   LIST                                            Instancias cargadas
+ *   QUIT                                            Termina el servidor
+ * 
+ * Respuestas: una línea "OK ..." o "ERR <motivo>". GET agrega una línea
+ * "celda trx frecuencia" por TRX a continuación del OK.
+ */
+class Servidor {
+public:
+    // Atiende comandos hasta QUIT o fin de la entrada
+    void atender(istream& in, ostream& out) {
+        string linea;
+        while (getline(in, linea)) {
+            if (!procesar(linea, out)) break;
+            out.flush();
+        }
+    }
+
+private:
+    map<string, TabuSearch> instancias;    // archivo -> estado residente (nodos estables: Solution guarda Problem*)
+
+    // Devuelve la instancia en caché, cargándola si es la primera vez
+    TabuSearch* obtener(const string& archivo, string& error) {
+        auto it = instancias.find(archivo);
+        if (it != instancias.end()) return &it->second;
+
+        auto& ts = instancias[archivo];
+        try {
+            if (!ts.problema.load(archivo)) {
+                instancias.erase(archivo);
+                error = "no se pudo cargar " + archivo;
+                return nullptr;
+            }
+            if (!ts.inicializar()) {
+                instancias.erase(archivo);
+                error = "no se pudo generar la solucion inicial de " + archivo;
+                return nullptr;
+            }
+        } catch (const exception& e) {
+            // p. ej. stoi con una demanda no numérica: descartar la instancia a medio cargar
+            instancias.erase(archivo);
+            error = "escenario invalido " + archivo + " (" + e.what() + ")";
+            return nullptr;
+        }
+        return &ts;
+    }
+
+    /**
+     * Lee un argumento opcional positivo
+     * @return true si no hay más argumentos o si se leyó un valor > 0;
+     *         false si el argumento existe pero no es válido
+     */
+    template <typename T>
+    static bool leer_opcional(stringstream& ss, T& valor) {
+        string tok;
+        if (!(ss >> tok)) return true;
+        stringstream conv(tok);
+        T v;
+        char resto;
+        if (!(conv >> v) || (conv >> resto) || v <= 0) return false;
+        valor = v;
+        return true;
+    }
+
+    string resumen(TabuSearch& ts) {
+        ostringstream os;
+        os << "costo=" << ts.mejor.costo
+           << " factible=" << (ts.mejor.es_factible() ? 1 : 0)
+           << " iter=" << ts.iter_global;
+        return os.str();
+    }
+
+    // Procesa un comando; devuelve false si el servidor debe terminar
+    bool procesar(const string& linea, ostream& out) {
+        auto inicio = high_resolution_clock::now();
+        auto ms = [&]() {
+            duration<double, milli> d = high_resolution_clock::now() - inicio;
+            return " ms=" + to_string(d.count());
+        };
+
+        stringstream ss(linea);
+        string cmd, archivo, error;
+        if (!(ss >> cmd)) return true;
+
+        if (cmd == "QUIT") {
+            out << "OK bye" << endl;
+            return false;
+        }
+        if (cmd == "LIST") {
+            out << "OK " << instancias.size();
+            for (auto& [nombre, ts] : instancias) out << " " << nombre;
+            out << endl;
+            return true;
+        }
+
+        static const set<string> comandos = {"LOAD", "SOLVE", "EDIT", "FREE", "GET", "RESET", "MODE", "STATS", "UNLOAD"};
+        if (!comandos.count(cmd)) {
+            out << "ERR comando desconocido: " << cmd << endl;
+            return true;
+        }
+        if (!(ss >> archivo)) {
+            out << "ERR falta archivo" << endl;
+            return true;
+        }
+
+        if (cmd == "UNLOAD") {
+            if (instancias.erase(archivo)) out << "OK" << endl;
+            else out << "ERR instancia no cargada" << endl;
+            return true;
+        }
+
+        bool cacheada = instancias.count(archivo) > 0;
+        TabuSearch* ts = obtener(archivo, error);
+        if (!ts) {
+            out << "ERR " << error << endl;
+            return true;
+        }
+
+        if (cmd == "LOAD") {
+            out << "OK " << (cacheada ? "cached " : "loaded ") << resumen(*ts) << ms() << endl;
+        } else if (cmd == "RESET") {
+            if (!ts->inicializar()) {
+                out << "ERR no se pudo generar la solucion inicial" << endl;
+                return true;
+            }
+            out << "OK " << resumen(*ts) << ms() << endl;
+        } else if (cmd == "STATS") {
+            out << "OK " << ts->estadisticas_ciclos() << endl;
+        } else if (cmd == "MODE") {
+            string modo;
+            ss >> modo;
+            if (modo == "best-frequency") {
+                ts->vecindario = Vecindario::BEST_FREQUENCY;
+                out << "OK best-frequency" << endl;
+            } else if (modo == "candidate-list") {
+                ts->vecindario = Vecindario::CANDIDATE_LIST;
+                out << "OK candidate-list" << endl;
+            } else {
+                out << "ERR uso: MODE <archivo> candidate-list|best-frequency" << endl;
+            }
+        } else if (cmd == "SOLVE") {
+            double segundos = 0.0;
+            int max_iter = INT_MAX;
+            if (!(ss >> segundos) || segundos <= 0.0 || !leer_opcional(ss, max_iter)) {
+                out << "ERR uso: SOLVE <archivo> <segundos> [max_iter] (valores positivos)" << endl;
+                return true;
+            }
+            int hechas = 0;
+            if (fabs(ts->mejor.costo) >= 1e-9) {
+                hechas = ts->optimizar(max_iter, segundos, nullptr, false);
+            }
+            out << "OK " << resumen(*ts) << " hechas=" << hechas << ms() << endl;
+        } else if (cmd == "EDIT") {
+            int cell_id, trx, freq;
+            double segundos = EDIT_REOPT_SECONDS;
+            if (!(ss >> cell_id >> trx >> freq) || trx < 1 || !leer_opcional(ss, segundos)) {
+                out << "ERR uso: EDIT <archivo> <celda> <trx> <freq> [segundos]" << endl;
+                return true;
+            }
+            if (!ts->fijar_trx(cell_id, trx - 1, freq, error)) {
+                out << "ERR " << error << endl;
+                return true;
+            }
+            int hechas = 0;
+            if (fabs(ts->mejor.costo) >= 1e-9) {
+                hechas = ts->optimizar(INT_MAX, segundos, nullptr, false);
+            }
+            out << "OK " << resumen(*ts) << " hechas=" << hechas << ms() << endl;
+        } else if (cmd == "FREE") {
+            int cell_id, trx;
+            if (!(ss >> cell_id >> trx) || trx < 1) {
+                out << "ERR uso: FREE <archivo> <celda> <trx>" << endl;
+            } else if (!ts->liberar_trx(cell_id, trx - 1)) {
+                out << "ERR trx no fijado" << endl;
+            } else {
+                out << "OK" << endl;
+            }
+        } else if (cmd == "GET") {
+            map<int, vector<int>> ordenada(ts->mejor.asignacion.begin(), ts->mejor.asignacion.end());
+            int total = 0;
+            for (auto& [id, freqs] : ordenada) total += freqs.size();
+            out << "OK " << total << " " << resumen(*ts) << endl;
+            for (auto& [id, freqs] : ordenada) {
+                for (size_t i = 0; i < freqs.size(); ++i) {
+                    out << id << " " << (i + 1) << " " << freqs[i] << "\n";
+                }
+            }
+        }
+        return true;
+    }
+};
+
 int main(int argc, char* argv[]) {
+    // Uso: ./fap_solver [archivo.scen] [--best-freq]   |   ./fap_solver --server
+    // Las opciones pueden ir en cualquier posición; --server no admite archivo ni --best-freq
     string archivo = "Tiny.scen";
-    if (argc > 1) archivo = argv[1];
+    bool servidor = false;
+    bool best_freq = false;
+    bool archivo_dado = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--server") {
+            servidor = true;
+        } else if (arg == "--best-freq") {
+            best_freq = true;
+        } else if (arg.rfind("--", 0) == 0 || archivo_dado) {
+            cerr << "Uso: " << argv[0] << " [archivo.scen] [--best-freq] | --server" << endl;
+            return 1;
+        } else {
+            archivo = arg;
+            archivo_dado = true;
+        }
+    }
+
+    // En modo servidor las instancias y el vecindario se eligen con LOAD / MODE
+    if (servidor && (archivo_dado || best_freq)) {
+        cerr << "Uso: " << argv[0] << " [archivo.scen] [--best-freq] | --server" << endl;
+        return 1;
+    }
+
+    if (servidor) {
+        Servidor srv;
+        srv.atender(cin, cout);
+        return 0;
+    }
     
     TabuSearch ts;
+    if (best_freq) {
+        ts.vecindario = Vecindario::BEST_FREQUENCY;
+    }
     ts.ejecutar(archivo);
     return 0;
-}
\ No newline at end of file
+}